@@ -0,0 +1,128 @@
+#ifndef LISTA_ADJ_COMPACTA_H
+#define LISTA_ADJ_COMPACTA_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Lista de adjacência compacta: vizinhos ordenados e codificados por diferença
+// (delta) em varint; pesos deslocados pelo menor peso e gravados com a menor
+// largura em bytes que comporta a faixa (0 bytes quando todos são iguais, o que
+// também serve para grafos sem peso).
+class ListaAdjCompacta {
+private:
+    std::vector<size_t> inicio;
+    std::vector<uint8_t> dados;
+    int pesoMinimo;
+    int larguraPeso;
+    int anterior;
+
+public:
+    ListaAdjCompacta() : inicio(1, 0), pesoMinimo(0), larguraPeso(0), anterior(0) {}
+
+    void limpar() {
+        inicio.assign(1, 0);
+        dados.clear();
+        anterior = 0;
+    }
+
+    // Deve ser chamado antes de adicionar vizinhos
+    void definirFaixaPesos(int menor, int maior) {
+        pesoMinimo = menor;
+        uint32_t faixa = (uint32_t)maior - (uint32_t)menor;
+        larguraPeso = 0;
+        while (faixa > 0) {
+            larguraPeso++;
+            faixa >>= 8;
+        }
+    }
+
+    // Os vizinhos de cada vértice chegam em ordem crescente, e os vértices na
+    // ordem 0, 1, ..., n-1, cada um encerrado por fecharVertice()
+    void adicionarVizinho(int v, int peso) {
+        uint32_t delta = v - anterior;
+        anterior = v;
+        while (delta >= 0x80) {
+            dados.push_back((delta & 0x7F) | 0x80);
+            delta >>= 7;
+        }
+        dados.push_back(delta);
+
+        uint32_t pesoDeslocado = (uint32_t)peso - (uint32_t)pesoMinimo;
+        for (int b = 0; b < larguraPeso; b++) {
+            dados.push_back(pesoDeslocado & 0xFF);
+            pesoDeslocado >>= 8;
+        }
+    }
+
+    void fecharVertice() {
+        inicio.push_back(dados.size());
+        anterior = 0;
+    }
+
+    void finalizar() {
+        inicio.shrink_to_fit();
+        dados.shrink_to_fit();
+    }
+
+    // Posição de leitura nos vizinhos de um vértice, para quem precisa
+    // interromper a decodificação e retomá-la depois (como uma DFS iterativa)
+    struct Cursor {
+        size_t posicao, fim;
+        int vizinho;
+    };
+
+    Cursor cursor(int u) const {
+        return Cursor{inicio[u], inicio[u + 1], 0};
+    }
+
+    // Decodifica o próximo vizinho do cursor; retorna false quando acabam
+    bool proximoVizinho(Cursor& c, int& v, int& peso) const {
+        if (c.posicao == c.fim) return false;
+
+        const uint8_t* p = dados.data() + c.posicao;
+        uint32_t delta = 0;
+        int deslocamento = 0;
+        while (*p & 0x80) {
+            delta |= (uint32_t)(*p++ & 0x7F) << deslocamento;
+            deslocamento += 7;
+        }
+        delta |= (uint32_t)(*p++) << deslocamento;
+        c.vizinho += delta;
+
+        uint32_t pesoDeslocado = 0;
+        for (int b = 0; b < larguraPeso; b++) {
+            pesoDeslocado |= (uint32_t)(*p++) << (8 * b);
+        }
+
+        c.posicao = p - dados.data();
+        v = c.vizinho;
+        peso = (int)(pesoDeslocado + (uint32_t)pesoMinimo);
+        return true;
+    }
+
+    template <typename Funcao>
+    void paraCadaVizinho(int u, Funcao f) const {
+        existeVizinho(u, [&](int v, int peso) {
+            f(v, peso);
+            return false;
+        });
+    }
+
+    // Decodifica os vizinhos de u até o predicado retornar true
+    template <typename Predicado>
+    bool existeVizinho(int u, Predicado pred) const {
+        Cursor c = cursor(u);
+        int v, peso;
+        while (proximoVizinho(c, v, peso)) {
+            if (pred(v, peso)) return true;
+        }
+        return false;
+    }
+
+    size_t memoriaBytes() const {
+        return inicio.capacity() * sizeof(size_t) + dados.capacity();
+    }
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <filesystem>
+
+// Modo lote (-m) compartilhado por kosaraju, prim e kruskal: listagem dos
+// arquivos, pool de threads com roubo de trabalho e o laço que aplica o
+// algoritmo de cada ferramenta a todos os grafos.
+
+struct TarefaLote {
+    std::string entrada, saida;
+};
+
+// Monta a lista de arquivos do modo lote. Um diretório processa todos os arquivos
+// regulares dele, gravando cada saída com o mesmo nome em diretorioSaida; um
+// manifesto tem uma linha "<entrada> <saida>" por grafo. Falhas do sistema de
+// arquivos viram mensagem em stderr e retorno false, nunca exceção.
+inline bool listarTarefasLote(const std::string& caminho, const std::string& diretorioSaida,
+                              std::vector<TarefaLote>& tarefas) {
+    namespace fs = std::filesystem;
+    std::error_code erro;
+
+    // Se não der para consultar o caminho, ele segue como manifesto e a
+    // abertura do arquivo lá embaixo reporta o problema
+    if (fs::is_directory(caminho, erro)) {
+        if (diretorioSaida.empty()) {
+            std::cerr << "Erro: o modo lote com diretório exige -o <diretório_saida>." << std::endl;
+            return false;
+        }
+        fs::create_directories(diretorioSaida, erro);
+        if (erro || !fs::is_directory(diretorioSaida, erro)) {
+            std::cerr << "Erro ao criar diretório de saída " << diretorioSaida
+                      << (erro ? ": " + erro.message() : "") << std::endl;
+            return false;
+        }
+
+        if (fs::equivalent(caminho, diretorioSaida, erro)) {
+            std::cerr << "Erro: o diretório de saída não pode ser o de entrada." << std::endl;
+            return false;
+        }
+
+        fs::directory_iterator it(caminho, erro);
+        for (; !erro && it != fs::directory_iterator(); it.increment(erro)) {
+            bool regular = it->is_regular_file(erro);
+            if (erro) break;
+            if (!regular) continue;
+            tarefas.push_back({it->path().string(), (fs::path(diretorioSaida) / it->path().filename()).string()});
+        }
+        if (erro) {
+            std::cerr << "Erro ao listar o diretório " << caminho << ": " << erro.message() << std::endl;
+            return false;
+        }
+        std::sort(tarefas.begin(), tarefas.end(),
+                  [](const TarefaLote& a, const TarefaLote& b) { return a.entrada < b.entrada; });
+        return true;
+    }
+
+    std::ifstream manifesto(caminho);
+    if (!manifesto.is_open()) {
+        std::cerr << "Erro ao abrir manifesto: " << caminho << std::endl;
+        return false;
+    }
+
+    std::string linha;
+    while (std::getline(manifesto, linha)) {
+        std::istringstream ss(linha);
+        TarefaLote tarefa;
+        if (!(ss >> tarefa.entrada)) continue;
+        if (!(ss >> tarefa.saida)) {
+            std::cerr << "Erro: linha do manifesto sem arquivo de saída: " << linha << std::endl;
+            return false;
+        }
+        tarefas.push_back(tarefa);
+    }
+    return true;
+}
+
+// Pool de threads com roubo de trabalho: cada thread começa com um bloco contíguo
+// de tarefas, consome o fim da própria fila e, quando ela esvazia, rouba do
+// início da fila de outra thread. f(tarefa, idThread).
+template <typename Funcao>
+void executarComRoubo(int numThreads, int numTarefas, Funcao f) {
+    struct FilaTarefas {
+        std::mutex trava;
+        std::deque<int> tarefas;
+    };
+    std::vector<FilaTarefas> filas(numThreads);
+    for (int t = 0; t < numTarefas; t++) {
+        filas[(long long)t * numThreads / numTarefas].tarefas.push_back(t);
+    }
+
+    auto trabalhador = [&](int id) {
+        while (true) {
+            int tarefa = -1;
+            {
+                std::lock_guard<std::mutex> trava(filas[id].trava);
+                if (!filas[id].tarefas.empty()) {
+                    tarefa = filas[id].tarefas.back();
+                    filas[id].tarefas.pop_back();
+                }
+            }
+            for (int i = 1; tarefa < 0 && i < numThreads; i++) {
+                FilaTarefas& vitima = filas[(id + i) % numThreads];
+                std::lock_guard<std::mutex> trava(vitima.trava);
+                if (!vitima.tarefas.empty()) {
+                    tarefa = vitima.tarefas.front();
+                    vitima.tarefas.pop_front();
+                }
+            }
+            if (tarefa < 0) return; // nenhuma tarefa nova surge depois do início
+            f(tarefa, id);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int id = 1; id < numThreads; id++) {
+        threads.emplace_back(trabalhador, id);
+    }
+    trabalhador(0);
+    for (std::thread& th : threads) th.join();
+}
+
+// Roda processar(tarefa, arena, erro) em todas as tarefas, com uma Arena por
+// thread reaproveitada de um grafo para o outro. processar devolve false e
+// preenche erro quando a tarefa falha; a mensagem sai em stderr sem se misturar
+// às das outras threads. Mostra grafos/s em stderr e retorna 1 se algo falhou.
+template <typename Arena, typename Processar>
+int processarLote(const std::vector<TarefaLote>& tarefas, int numThreads, Processar processar) {
+    numThreads = std::max(1, std::min<int>(numThreads, tarefas.size()));
+    std::vector<Arena> arenas(numThreads);
+    std::mutex travaErros;
+    std::atomic<int> falhas(0);
+
+    auto t0 = std::chrono::steady_clock::now();
+    executarComRoubo(numThreads, tarefas.size(), [&](int t, int id) {
+        std::string erro;
+        if (!processar(tarefas[t], arenas[id], erro)) {
+            std::lock_guard<std::mutex> trava(travaErros);
+            std::cerr << erro << std::endl;
+            falhas++;
+        }
+    });
+    auto t1 = std::chrono::steady_clock::now();
+
+    double segundos = std::chrono::duration<double>(t1 - t0).count();
+    std::cerr << tarefas.size() - falhas << " grafos em " << segundos << " s ("
+              << (tarefas.size() - falhas) / std::max(segundos, 1e-9) << " grafos/s, "
+              << numThreads << " threads)" << std::endl;
+    return falhas > 0 ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef MEDICAO_H
+#define MEDICAO_H
+
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <utility>
+
+// Mede a e b alternadamente, após uma execução de aquecimento de cada, e retorna
+// a mediana dos tempos de cada um em ms. A ordem se inverte a cada rodada para
+// que nenhum dos dois fique sempre com a cache fria.
+template <typename FuncaoA, typename FuncaoB>
+std::pair<double, double> medirAlternado(FuncaoA a, FuncaoB b, int repeticoes = 5) {
+    std::vector<double> temposA, temposB;
+    a();
+    b();
+    for (int r = 0; r < repeticoes; r++) {
+        for (int vez = 0; vez < 2; vez++) {
+            bool medirA = (vez == r % 2);
+            auto t0 = std::chrono::steady_clock::now();
+            if (medirA) a(); else b();
+            auto t1 = std::chrono::steady_clock::now();
+            (medirA ? temposA : temposB).push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+        }
+    }
+    std::sort(temposA.begin(), temposA.end());
+    std::sort(temposB.begin(), temposB.end());
+    return {temposA[repeticoes / 2], temposB[repeticoes / 2]};
+}
+
+#endif
@@ -6,26 +6,230 @@
 #include <string>
 #include <climits>
 #include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <cmath>
+#include "../comum/lista_adj_compacta.h"
+#include "../comum/medicao.h"
 using namespace std;
 
 typedef pair<int, int> par_int;
 
+// Divide [0, total) em blocos contíguos, um por thread; f(inicio, fim, idThread)
+template <typename Funcao>
+void executarEmParalelo(int numThreads, size_t total, Funcao f) {
+    if (numThreads <= 1 || total <= 1) {
+        f((size_t)0, total, 0);
+        return;
+    }
+
+    vector<thread> threads;
+    size_t bloco = (total + numThreads - 1) / numThreads;
+    for (int t = 0; t < numThreads && t * bloco < total; t++) {
+        threads.emplace_back(f, t * bloco, min(total, (t + 1) * bloco), t);
+    }
+    for (thread& th : threads) th.join();
+}
+
+// Threads mantidas vivas entre rodadas: executar(f) roda f(id) em todas, com a
+// thread chamadora como id 0, e só retorna quando todas terminam. Evita criar
+// threads a cada nível da busca em largura.
+class EquipeThreads {
+private:
+    int numThreads;
+    vector<thread> threads;
+    mutex trava;
+    condition_variable inicioRodada, fimRodada;
+    const function<void(int)>* tarefa;
+    unsigned long rodada;
+    int pendentes;
+    bool encerrar;
+
+    void trabalhar(int id) {
+        unsigned long vista = 0;
+        while (true) {
+            const function<void(int)>* f;
+            {
+                unique_lock<mutex> l(trava);
+                inicioRodada.wait(l, [&] { return encerrar || rodada != vista; });
+                if (encerrar) return;
+                vista = rodada;
+                f = tarefa;
+            }
+
+            (*f)(id);
+
+            lock_guard<mutex> l(trava);
+            if (--pendentes == 0) fimRodada.notify_one();
+        }
+    }
+
+public:
+    explicit EquipeThreads(int n) : numThreads(n), tarefa(nullptr), rodada(0), pendentes(0), encerrar(false) {
+        for (int id = 1; id < n; id++) {
+            threads.emplace_back(&EquipeThreads::trabalhar, this, id);
+        }
+    }
+
+    ~EquipeThreads() {
+        {
+            lock_guard<mutex> l(trava);
+            encerrar = true;
+        }
+        inicioRodada.notify_all();
+        for (thread& th : threads) th.join();
+    }
+
+    void executar(const function<void(int)>& f) {
+        {
+            lock_guard<mutex> l(trava);
+            tarefa = &f;
+            pendentes = numThreads - 1;
+            rodada++;
+        }
+        inicioRodada.notify_all();
+
+        f(0);
+
+        unique_lock<mutex> l(trava);
+        fimRodada.wait(l, [&] { return pendentes == 0; });
+    }
+};
+
+// Landmarks para a busca ALT (A*, landmarks e desigualdade triangular):
+// distancias[i][v] é a distância entre o landmark i e o vértice v
+struct Landmarks {
+    int numVertices;
+    vector<int> vertices;
+    vector<vector<int>> distancias;
+
+    // Limite inferior de dist(v, destino) pela desigualdade triangular.
+    // O grafo é não direcionado, então dist(L, v) = dist(v, L).
+    int limiteInferior(int v, int destino) const {
+        int limite = 0;
+        for (const vector<int>& d : distancias) {
+            if (d[v] == INT_MAX || d[destino] == INT_MAX) continue;
+            limite = max(limite, abs(d[destino] - d[v]));
+        }
+        return limite;
+    }
+};
+
 class Grafo {
 private:
     int numVertices;
     vector<vector<par_int>> listaAdj;
+    ListaAdjCompacta listaCompacta;
+    bool compactado;
+    int pesoMinimo, pesoMaximo;
+    long long numArestas;
+    uint64_t somaHashArestas;
+
+    // Mistura de bits do splitmix64
+    static uint64_t misturar(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
 
 public:
-    Grafo(int vertices) : numVertices(vertices) {
+    Grafo(int vertices) : numVertices(vertices), compactado(false), pesoMinimo(INT_MAX), pesoMaximo(INT_MIN),
+                          numArestas(0), somaHashArestas(0) {
         listaAdj.resize(vertices);
     }
 
     void adicionarAresta(int u, int v, int peso) {
         listaAdj[u].push_back({v, peso});
         listaAdj[v].push_back({u, peso});
+        pesoMinimo = min(pesoMinimo, peso);
+        pesoMaximo = max(pesoMaximo, peso);
+        numArestas++;
+
+        // Soma dos hashes das arestas: não depende da ordem nem do sentido
+        uint64_t a = min(u, v), b = max(u, v);
+        somaHashArestas += misturar(misturar(misturar(a) ^ b) ^ (uint32_t)peso);
+    }
+
+    bool temPesoUniforme() const {
+        return pesoMinimo == pesoMaximo && pesoMinimo >= 0;
+    }
+
+    // A busca em largura inicializa e varre estruturas de n vértices; em grafos
+    // com menos arestas que vértices a maior parte fica inalcançável e o heap,
+    // que só toca o que alcança, sai mais barato
+    bool preferirBuscaEmLargura() const {
+        return temPesoUniforme() && numArestas >= (long long)numVertices;
+    }
+
+    // Converte a lista de adjacência para a forma compacta e libera a original
+    void compactar() {
+        if (compactado) return;
+
+        if (pesoMinimo > pesoMaximo) {
+            listaCompacta.definirFaixaPesos(0, 0);
+        } else {
+            listaCompacta.definirFaixaPesos(pesoMinimo, pesoMaximo);
+        }
+        for (auto &vizinhos : listaAdj) {
+            sort(vizinhos.begin(), vizinhos.end());
+            for (auto &aresta : vizinhos) {
+                listaCompacta.adicionarVizinho(aresta.first, aresta.second);
+            }
+            listaCompacta.fecharVertice();
+        }
+        listaCompacta.finalizar();
+
+        vector<vector<par_int>>().swap(listaAdj);
+        compactado = true;
+    }
+
+    template <typename Funcao>
+    void paraCadaVizinho(int u, Funcao f) const {
+        if (compactado) {
+            listaCompacta.paraCadaVizinho(u, f);
+        } else {
+            for (auto &aresta : listaAdj[u]) {
+                f(aresta.first, aresta.second);
+            }
+        }
+    }
+
+    template <typename Predicado>
+    bool existeVizinho(int u, Predicado pred) const {
+        if (compactado) return listaCompacta.existeVizinho(u, pred);
+
+        for (auto &aresta : listaAdj[u]) {
+            if (pred(aresta.first, aresta.second)) return true;
+        }
+        return false;
+    }
+
+    int grau(int u) const {
+        if (!compactado) return listaAdj[u].size();
+
+        int total = 0;
+        listaCompacta.paraCadaVizinho(u, [&](int, int) { total++; });
+        return total;
     }
 
-    vector<int> dijkstra(int inicio) {
+    size_t memoriaAdjacencia() const {
+        if (compactado) return listaCompacta.memoriaBytes();
+
+        size_t total = listaAdj.capacity() * sizeof(vector<par_int>);
+        for (auto &vizinhos : listaAdj) {
+            total += vizinhos.capacity() * sizeof(par_int);
+        }
+        return total;
+    }
+
+    vector<int> dijkstra(int inicio) const {
         vector<int> distancias(numVertices, INT_MAX);
         distancias[inicio] = 0;
 
@@ -39,10 +243,7 @@ public:
 
             if (distancia_atual > distancias[u]) continue;
 
-            for (auto &aresta : listaAdj[u]) {
-                int v = aresta.first;
-                int peso = aresta.second;
-
+            paraCadaVizinho(u, [&](int v, int peso) {
                 if (distancias[u] != INT_MAX) {
                     int nova_distancia = distancias[u] + peso;
                     if (nova_distancia < distancias[v]) {
@@ -50,13 +251,430 @@ public:
                         fila_prioridade.push({nova_distancia, v});
                     }
                 }
-            }
+            });
         }
 
         return distancias;
     }
+
+    // Caminhos mínimos quando todas as arestas têm o mesmo peso: busca em largura
+    // com otimização de direção (Beamer et al.) e distância = nível * peso.
+    // Top-down percorre a fronteira como fila esparsa; bottom-up, usado quando a
+    // fronteira cobre boa parte dos vértices restantes, testa os não visitados
+    // contra um mapa de bits da fronteira. Só níveis grandes acordam a equipe de
+    // threads, criada uma vez por busca; os demais rodam na thread chamadora, o
+    // que mantém grafos de grande diâmetro (grades, malhas viárias) sem custo
+    // de sincronização por nível.
+    vector<int> buscaEmLargura(int inicio, int numThreads) const {
+        const int alfa = 15, beta = 18;
+        const size_t limiarParalelo = 4096;
+        size_t numPalavras = (numVertices + 63) / 64;
+
+        vector<int> niveis(numVertices, INT_MAX);
+        vector<atomic<uint64_t>> visitados(numPalavras);
+        for (size_t w = 0; w < numPalavras; w++) {
+            visitados[w].store(0, memory_order_relaxed);
+        }
+        vector<uint64_t> mapaFronteira;
+        vector<int> fronteira(1, inicio);
+        vector<vector<int>> descobertos(max(numThreads, 1));
+        unique_ptr<EquipeThreads> equipe;
+
+        niveis[inicio] = 0;
+        visitados[inicio >> 6].store(1ULL << (inicio & 63), memory_order_relaxed);
+        long long naoVisitados = numVertices - 1;
+        bool ascendente = false;
+
+        for (int nivel = 0; !fronteira.empty(); nivel++) {
+            // Estimativa por vértices da regra de Beamer (arestas da fronteira
+            // contra arestas dos não visitados), sem precisar dos graus
+            long long tamanhoFronteira = fronteira.size();
+            if (!ascendente && tamanhoFronteira > naoVisitados / alfa) {
+                ascendente = true;
+            } else if (ascendente && tamanhoFronteira < numVertices / beta) {
+                ascendente = false;
+            }
+
+            // Trabalho do nível: a fronteira no top-down, os não visitados no bottom-up
+            long long trabalho = ascendente ? naoVisitados : tamanhoFronteira;
+            int threadsNivel = 1;
+            if (numThreads > 1 && trabalho >= (long long)limiarParalelo) {
+                threadsNivel = numThreads;
+                if (!equipe) equipe.reset(new EquipeThreads(numThreads));
+            }
+            auto rodar = [&](const function<void(int)>& f) {
+                if (threadsNivel > 1) {
+                    equipe->executar(f);
+                } else {
+                    f(0);
+                }
+            };
+            for (vector<int>& lista : descobertos) lista.clear();
+
+            if (ascendente) {
+                mapaFronteira.assign(numPalavras, 0);
+                for (int u : fronteira) {
+                    mapaFronteira[u >> 6] |= 1ULL << (u & 63);
+                }
+
+                // Bottom-up: cada vértice não visitado procura um pai na fronteira.
+                // A thread é dona das palavras do seu bloco, então escreve nelas sem disputa.
+                rodar([&](int id) {
+                    size_t bloco = (numPalavras + threadsNivel - 1) / threadsNivel;
+                    size_t primeira = min(numPalavras, id * bloco);
+                    size_t ultima = min(numPalavras, primeira + bloco);
+
+                    for (size_t w = primeira; w < ultima; w++) {
+                        uint64_t pendentes = ~visitados[w].load(memory_order_relaxed);
+                        if (w == numPalavras - 1 && numVertices % 64 != 0) {
+                            pendentes &= (1ULL << (numVertices % 64)) - 1;
+                        }
+
+                        uint64_t achados = 0;
+                        while (pendentes) {
+                            int b = __builtin_ctzll(pendentes);
+                            pendentes &= pendentes - 1;
+                            int v = w * 64 + b;
+
+                            bool achou = existeVizinho(v, [&](int u, int) {
+                                return (mapaFronteira[u >> 6] >> (u & 63)) & 1;
+                            });
+                            if (achou) {
+                                achados |= 1ULL << b;
+                                niveis[v] = nivel + 1;
+                                descobertos[id].push_back(v);
+                            }
+                        }
+
+                        if (achados) visitados[w].fetch_or(achados, memory_order_relaxed);
+                    }
+                });
+            } else {
+                // Top-down: a fronteira expande os vizinhos, disputando cada bit
+                rodar([&](int id) {
+                    size_t bloco = (fronteira.size() + threadsNivel - 1) / threadsNivel;
+                    size_t primeiro = min(fronteira.size(), id * bloco);
+                    size_t ultimo = min(fronteira.size(), primeiro + bloco);
+
+                    for (size_t i = primeiro; i < ultimo; i++) {
+                        paraCadaVizinho(fronteira[i], [&](int v, int) {
+                            uint64_t bit = 1ULL << (v & 63);
+                            if (visitados[v >> 6].load(memory_order_relaxed) & bit) return;
+                            if (visitados[v >> 6].fetch_or(bit, memory_order_relaxed) & bit) return;
+
+                            niveis[v] = nivel + 1;
+                            descobertos[id].push_back(v);
+                        });
+                    }
+                });
+            }
+
+            fronteira.clear();
+            for (const vector<int>& lista : descobertos) {
+                fronteira.insert(fronteira.end(), lista.begin(), lista.end());
+            }
+            naoVisitados -= fronteira.size();
+        }
+
+        for (int& nivel : niveis) {
+            if (nivel != INT_MAX) nivel *= pesoMinimo;
+        }
+        return niveis;
+    }
+
+    // Distância de origem até destino, parando ao fixar o destino. Com landmarks
+    // a fila é ordenada por distância + limite inferior (A*), o que fixa menos
+    // vértices e dá o mesmo resultado, pois o limite é consistente.
+    int distanciaPontoAPonto(int origem, int destino, const Landmarks* landmarks, int* fixados = nullptr) const {
+        vector<int> distancias(numVertices, INT_MAX);
+        vector<int> limites(numVertices, -1);
+        vector<bool> fixado(numVertices, false);
+        int totalFixados = 0;
+
+        auto limite = [&](int v) {
+            if (!landmarks) return 0;
+            if (limites[v] < 0) limites[v] = landmarks->limiteInferior(v, destino);
+            return limites[v];
+        };
+
+        priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<pair<long long, int>>> fila_prioridade;
+        distancias[origem] = 0;
+        fila_prioridade.push({limite(origem), origem});
+
+        while (!fila_prioridade.empty()) {
+            int u = fila_prioridade.top().second;
+            fila_prioridade.pop();
+
+            if (fixado[u]) continue;
+            fixado[u] = true;
+            totalFixados++;
+
+            if (u == destino) break;
+
+            paraCadaVizinho(u, [&](int v, int peso) {
+                int nova_distancia = distancias[u] + peso;
+                if (!fixado[v] && nova_distancia < distancias[v]) {
+                    distancias[v] = nova_distancia;
+                    fila_prioridade.push({(long long)nova_distancia + limite(v), v});
+                }
+            });
+        }
+
+        if (fixados) *fixados = totalFixados;
+        return distancias[destino];
+    }
+
+    int obterNumVertices() const { return numVertices; }
+    long long obterNumArestas() const { return numArestas; }
+    int obterPesoMinimo() const { return pesoMinimo; }
+    int obterPesoMaximo() const { return pesoMaximo; }
+
+    // Identifica o grafo lido (vértices, arestas e pesos), usado para validar landmarks
+    uint64_t impressaoDigital() const {
+        return misturar(misturar(numVertices) ^ (uint64_t)numArestas) ^ somaHashArestas;
+    }
 };
 
+// Escolhe k landmarks pela heurística "farthest": cada novo landmark é o vértice
+// mais distante dos já escolhidos (vértices inalcançáveis vêm primeiro, cobrindo
+// outros componentes). A primeira busca parte do vértice 1.
+Landmarks escolherLandmarks(const Grafo& g, int k) {
+    int n = g.obterNumVertices();
+    Landmarks landmarks;
+    landmarks.numVertices = n;
+    if (n == 0) return landmarks;
+
+    vector<int> menorDistancia = g.dijkstra(0);
+    while ((int)landmarks.vertices.size() < min(k, n)) {
+        int escolhido = 0;
+        for (int v = 1; v < n; v++) {
+            if (menorDistancia[v] > menorDistancia[escolhido]) escolhido = v;
+        }
+
+        landmarks.vertices.push_back(escolhido);
+        landmarks.distancias.push_back(g.dijkstra(escolhido));
+
+        const vector<int>& d = landmarks.distancias.back();
+        for (int v = 0; v < n; v++) {
+            menorDistancia[v] = min(menorDistancia[v], d[v]);
+        }
+        menorDistancia[escolhido] = -1;
+    }
+
+    return landmarks;
+}
+
+// Formato binário: "ALT1", n, k (int32), a impressão digital do grafo (uint64),
+// os k vértices e as k tabelas de n distâncias (int32)
+void salvarLandmarks(const Landmarks& landmarks, const Grafo& g, const string& nomeArquivo) {
+    ofstream arquivo(nomeArquivo, ios::binary);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir arquivo de landmarks: " << nomeArquivo << endl;
+        exit(1);
+    }
+
+    int32_t n = landmarks.numVertices;
+    int32_t k = landmarks.vertices.size();
+    arquivo.write("ALT1", 4);
+    arquivo.write((const char*)&n, sizeof(n));
+    arquivo.write((const char*)&k, sizeof(k));
+    uint64_t impressao = g.impressaoDigital();
+    arquivo.write((const char*)&impressao, sizeof(impressao));
+    arquivo.write((const char*)landmarks.vertices.data(), k * sizeof(int32_t));
+    for (const vector<int>& d : landmarks.distancias) {
+        arquivo.write((const char*)d.data(), n * sizeof(int32_t));
+    }
+    arquivo.close();
+}
+
+// Rejeita arquivos gerados para outro grafo, mesmo com o mesmo número de vértices,
+// pois limites de outro grafo deixariam de ser válidos e o A* erraria a distância
+Landmarks carregarLandmarks(const string& nomeArquivo, const Grafo& g) {
+    ifstream arquivo(nomeArquivo, ios::binary);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir arquivo de landmarks: " << nomeArquivo << endl;
+        exit(1);
+    }
+
+    char assinatura[4];
+    int32_t n = 0, k = 0;
+    uint64_t impressao = 0;
+    arquivo.read(assinatura, 4);
+    arquivo.read((char*)&n, sizeof(n));
+    arquivo.read((char*)&k, sizeof(k));
+    arquivo.read((char*)&impressao, sizeof(impressao));
+    if (!arquivo || string(assinatura, 4) != "ALT1" || n != g.obterNumVertices() || k < 0 || k > n ||
+        impressao != g.impressaoDigital()) {
+        cerr << "Arquivo de landmarks inválido para este grafo: " << nomeArquivo << endl;
+        exit(1);
+    }
+
+    // Confere o tamanho antes de alocar as tabelas: k vértices e k x n distâncias
+    streampos posicaoTabelas = arquivo.tellg();
+    arquivo.seekg(0, ios::end);
+    uint64_t restante = (uint64_t)(arquivo.tellg() - posicaoTabelas);
+    arquivo.seekg(posicaoTabelas);
+    if (restante != (uint64_t)k * (n + 1) * sizeof(int32_t)) {
+        cerr << "Arquivo de landmarks com tamanho inválido: " << nomeArquivo << endl;
+        exit(1);
+    }
+
+    Landmarks landmarks;
+    landmarks.numVertices = n;
+    landmarks.vertices.resize(k);
+    landmarks.distancias.assign(k, vector<int>(n));
+    arquivo.read((char*)landmarks.vertices.data(), k * sizeof(int32_t));
+    for (vector<int>& d : landmarks.distancias) {
+        arquivo.read((char*)d.data(), n * sizeof(int32_t));
+    }
+    if (!arquivo) {
+        cerr << "Arquivo de landmarks incompleto: " << nomeArquivo << endl;
+        exit(1);
+    }
+
+    arquivo.close();
+    return landmarks;
+}
+
+// Caminhos mínimos entre todos os pares. O Floyd–Warshall é feito em blocos de
+// TAMANHO_BLOCO x TAMANHO_BLOCO que cabem na cache; o Dijkstra repetido reaproveita
+// a mesma lista de adjacência em todas as threads.
+enum class MotorTodosPares { AUTOMATICO, FLOYD_WARSHALL, DIJKSTRA };
+
+const int TAMANHO_BLOCO = 64;
+const int INF_MATRIZ = INT_MAX / 2; // a soma de dois INF_MATRIZ não estoura
+
+// c[i][j] = min(c[i][j], a[i][k] + b[k][j]) dentro de um bloco; c pode coincidir
+// com a ou b (blocos da diagonal, linha e coluna do pivô)
+void relaxarBloco(int* c, const int* a, const int* b, int largura) {
+    for (int k = 0; k < TAMANHO_BLOCO; k++) {
+        for (int i = 0; i < TAMANHO_BLOCO; i++) {
+            int aik = a[i * largura + k];
+            int* ci = c + i * largura;
+            const int* bk = b + k * largura;
+            for (int j = 0; j < TAMANHO_BLOCO; j++) {
+                ci[j] = min(ci[j], aik + bk[j]);
+            }
+        }
+    }
+}
+
+// Mesma operação para blocos fora da linha e da coluna do pivô, que nunca
+// coincidem com a ou b; sem sobreposição o laço interno é vetorizado
+void relaxarBlocoIndependente(int* __restrict c, const int* __restrict a, const int* __restrict b, int largura) {
+    for (int k = 0; k < TAMANHO_BLOCO; k++) {
+        for (int i = 0; i < TAMANHO_BLOCO; i++) {
+            int aik = a[i * largura + k];
+            int* __restrict ci = c + i * largura;
+            const int* __restrict bk = b + k * largura;
+            for (int j = 0; j < TAMANHO_BLOCO; j++) {
+                ci[j] = min(ci[j], aik + bk[j]);
+            }
+        }
+    }
+}
+
+vector<vector<int>> floydWarshallBlocado(const Grafo& g, int numThreads) {
+    int n = g.obterNumVertices();
+    int numBlocos = (n + TAMANHO_BLOCO - 1) / TAMANHO_BLOCO;
+    int largura = numBlocos * TAMANHO_BLOCO;
+
+    vector<int> matriz((size_t)largura * largura, INF_MATRIZ);
+    for (int u = 0; u < n; u++) {
+        int* linha = &matriz[(size_t)u * largura];
+        linha[u] = 0;
+        g.paraCadaVizinho(u, [&](int v, int peso) {
+            linha[v] = min(linha[v], peso);
+        });
+    }
+
+    auto bloco = [&](int bi, int bj) {
+        return &matriz[(size_t)bi * TAMANHO_BLOCO * largura + (size_t)bj * TAMANHO_BLOCO];
+    };
+
+    for (int bk = 0; bk < numBlocos; bk++) {
+        int* pivo = bloco(bk, bk);
+        relaxarBloco(pivo, pivo, pivo, largura);
+
+        // Linha e coluna do pivô
+        executarEmParalelo(numThreads, 2 * numBlocos, [&](size_t primeiro, size_t ultimo, int) {
+            for (size_t t = primeiro; t < ultimo; t++) {
+                int b = t / 2;
+                if (b == bk) continue;
+                if (t % 2 == 0) {
+                    relaxarBloco(bloco(bk, b), pivo, bloco(bk, b), largura);
+                } else {
+                    relaxarBloco(bloco(b, bk), bloco(b, bk), pivo, largura);
+                }
+            }
+        });
+
+        // Demais blocos
+        executarEmParalelo(numThreads, (size_t)numBlocos * numBlocos, [&](size_t primeiro, size_t ultimo, int) {
+            for (size_t t = primeiro; t < ultimo; t++) {
+                int bi = t / numBlocos, bj = t % numBlocos;
+                if (bi == bk || bj == bk) continue;
+                relaxarBlocoIndependente(bloco(bi, bj), bloco(bi, bk), bloco(bk, bj), largura);
+            }
+        });
+    }
+
+    vector<vector<int>> distancias(n, vector<int>(n));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            int d = matriz[(size_t)i * largura + j];
+            distancias[i][j] = (d >= INF_MATRIZ) ? INT_MAX : d;
+        }
+    }
+    return distancias;
+}
+
+vector<vector<int>> dijkstraRepetido(const Grafo& g, int numThreads) {
+    int n = g.obterNumVertices();
+    vector<vector<int>> distancias(n);
+    atomic<int> proximaOrigem(0);
+
+    // Origens distribuídas sob demanda: buscas que alcançam mais vértices demoram mais
+    executarEmParalelo(numThreads, numThreads, [&](size_t, size_t, int) {
+        for (int s = proximaOrigem++; s < n; s = proximaOrigem++) {
+            distancias[s] = g.preferirBuscaEmLargura() ? g.buscaEmLargura(s, 1) : g.dijkstra(s);
+        }
+    });
+    return distancias;
+}
+
+// Estima o custo dos dois motores: n^3 relaxamentos vetorizados contra n buscas
+// de custo ~m log n cada. A constante do Dijkstra foi medida com n = 2000, onde
+// os dois empatam perto de m = 150000 (grau médio ~150).
+MotorTodosPares escolherMotor(const Grafo& g) {
+    double n = g.obterNumVertices();
+    double m = g.obterNumArestas();
+    double custoFloyd = n * n * n;
+    double custoDijkstra = 2.5 * n * m * log2(max(n, 2.0));
+    return custoFloyd <= custoDijkstra ? MotorTodosPares::FLOYD_WARSHALL : MotorTodosPares::DIJKSTRA;
+}
+
+// A matriz do Floyd–Warshall trata valores a partir de INF_MATRIZ como ausência de
+// caminho; só é usada se nenhum caminho mínimo (até n - 1 arestas) chega lá
+bool floydSemEstouro(const Grafo& g) {
+    if (g.obterNumArestas() == 0) return true;
+    long long maiorCaminho = (long long)g.obterPesoMaximo() * max(g.obterNumVertices() - 1, 1);
+    return g.obterPesoMinimo() >= 0 && maiorCaminho < INF_MATRIZ;
+}
+
+// Motor efetivamente usado: o automático segue a estimativa de custo e o
+// Floyd–Warshall cede ao Dijkstra quando os pesos podem estourar a matriz
+MotorTodosPares resolverMotor(const Grafo& g, MotorTodosPares motor) {
+    if (motor == MotorTodosPares::AUTOMATICO) motor = escolherMotor(g);
+    if (motor == MotorTodosPares::FLOYD_WARSHALL && !floydSemEstouro(g)) motor = MotorTodosPares::DIJKSTRA;
+    return motor;
+}
+
+vector<vector<int>> todosOsPares(const Grafo& g, MotorTodosPares motor, int numThreads) {
+    if (resolverMotor(g, motor) == MotorTodosPares::FLOYD_WARSHALL) return floydWarshallBlocado(g, numThreads);
+    return dijkstraRepetido(g, numThreads);
+}
+
 Grafo lerFormatoSimples(const string& nomeArquivo) {
     ifstream arquivo(nomeArquivo);
     if (!arquivo.is_open()) {
@@ -109,18 +727,54 @@ void imprimirResultados(const vector<int>& distancias, int inicio, ostream& out
     out << endl;
 }
 
+// Formato binário: n (int32) e a matriz n x n de distâncias int32 por linhas, -1 se inalcançável
+void imprimirMatrizBinaria(const vector<vector<int>>& distancias, ostream& out) {
+    int32_t n = distancias.size();
+    out.write((const char*)&n, sizeof(n));
+
+    vector<int32_t> linha(n);
+    for (const vector<int>& d : distancias) {
+        for (int j = 0; j < n; j++) {
+            linha[j] = (d[j] == INT_MAX) ? -1 : d[j];
+        }
+        out.write((const char*)linha.data(), n * sizeof(int32_t));
+    }
+}
+
 void mostrarHelp(const string& nomePrograma) {
-    cout << "Uso: " << nomePrograma << " -f <arquivo> [-o <arquivo_saida>] [-i <vertice_inicial>]" << endl;
+    cout << "Uso: " << nomePrograma << " -f <arquivo> [-o <arquivo_saida>] [-i <vertice_inicial>] [-d <vertice_destino>]" << endl;
     cout << "Opções:" << endl;
     cout << "  -h              : Mostra este help" << endl;
     cout << "  -f <arquivo>    : Arquivo de entrada com o grafo" << endl;
     cout << "  -o <arquivo>    : Redireciona a saída para o arquivo" << endl;
     cout << "  -i <vertice>    : Vértice inicial (padrão: 1)" << endl;
+    cout << "  -d <vertice>    : Consulta ponto a ponto: imprime só a distância até o destino" << endl;
+    cout << "  -g <arquivo>    : Pré-processa os landmarks (ALT) e os salva no arquivo" << endl;
+    cout << "  -k <num>        : Número de landmarks gerados com -g (padrão: 8)" << endl;
+    cout << "  -l <arquivo>    : Carrega landmarks e usa A* (ALT) na consulta com -d" << endl;
+    cout << "  -a              : Todos os pares: uma linha de distâncias por vértice de origem" << endl;
+    cout << "  -e <motor>      : Motor do modo -a: auto, floyd ou dijkstra (padrão: auto); floyd cede" << endl;
+    cout << "                    ao dijkstra se os pesos puderem estourar a matriz" << endl;
+    cout << "  -B              : No modo -a, grava a matriz em binário (n e n x n int32)" << endl;
+    cout << "  -c              : Usa a lista de adjacência compacta (menos memória)" << endl;
+    cout << "  -t <num>        : Threads da busca em largura (pesos iguais) e dos motores do modo -a (padrão: núcleos)" << endl;
+    cout << "  -b              : Benchmark em stderr: com -a compara os dois motores; com -d compara Dijkstra e ALT;" << endl;
+    cout << "                    sem -d compara memória e tempo das listas comum e compacta" << endl;
+    cout << "                    e, com pesos iguais, a busca em largura contra o heap" << endl;
 }
 
 int main(int argc, char* argv[]) {
     string nomeArquivo, arquivoSaida;
     int inicio = 0; // 0-based, padrão vértice 1
+    int destino = -1;
+    bool pontoAPonto = false;
+    int numLandmarks = 8;
+    string arquivoGerarLandmarks, arquivoLandmarks;
+    int numThreads = max(1u, thread::hardware_concurrency());
+    bool todosPares = false, saidaBinaria = false;
+    MotorTodosPares motor = MotorTodosPares::AUTOMATICO;
+    bool usarCompacta = false;
+    bool benchmark = false;
 
     // Parse arguments
     for (int i = 1; i < argc; i++) {
@@ -134,6 +788,37 @@ int main(int argc, char* argv[]) {
             arquivoSaida = argv[++i];
         } else if (arg == "-i" && i + 1 < argc) {
             inicio = stoi(argv[++i]) - 1; // Converter para 0-based
+        } else if (arg == "-d" && i + 1 < argc) {
+            destino = stoi(argv[++i]) - 1;
+            pontoAPonto = true;
+        } else if (arg == "-g" && i + 1 < argc) {
+            arquivoGerarLandmarks = argv[++i];
+        } else if (arg == "-k" && i + 1 < argc) {
+            numLandmarks = stoi(argv[++i]);
+        } else if (arg == "-l" && i + 1 < argc) {
+            arquivoLandmarks = argv[++i];
+        } else if (arg == "-t" && i + 1 < argc) {
+            numThreads = max(1, stoi(argv[++i]));
+        } else if (arg == "-a") {
+            todosPares = true;
+        } else if (arg == "-e" && i + 1 < argc) {
+            string nomeMotor = argv[++i];
+            if (nomeMotor == "floyd") {
+                motor = MotorTodosPares::FLOYD_WARSHALL;
+            } else if (nomeMotor == "dijkstra") {
+                motor = MotorTodosPares::DIJKSTRA;
+            } else if (nomeMotor == "auto") {
+                motor = MotorTodosPares::AUTOMATICO;
+            } else {
+                cerr << "Erro: motor desconhecido: " << nomeMotor << " (use auto, floyd ou dijkstra)" << endl;
+                return 1;
+            }
+        } else if (arg == "-B") {
+            saidaBinaria = true;
+        } else if (arg == "-c") {
+            usarCompacta = true;
+        } else if (arg == "-b") {
+            benchmark = true;
         }
     }
 
@@ -144,7 +829,156 @@ int main(int argc, char* argv[]) {
     }
 
     Grafo g = lerFormatoSimples(nomeArquivo);
-    vector<int> distancias = g.dijkstra(inicio);
+
+    if (!arquivoGerarLandmarks.empty()) {
+        if (usarCompacta) g.compactar();
+        salvarLandmarks(escolherLandmarks(g, numLandmarks), g, arquivoGerarLandmarks);
+        return 0;
+    }
+
+    if (todosPares) {
+        if (usarCompacta) g.compactar();
+
+        auto t0 = chrono::steady_clock::now();
+        vector<vector<int>> distancias = todosOsPares(g, motor, numThreads);
+        auto t1 = chrono::steady_clock::now();
+
+        MotorTodosPares escolhido = resolverMotor(g, motor);
+        MotorTodosPares outro = (escolhido == MotorTodosPares::FLOYD_WARSHALL) ? MotorTodosPares::DIJKSTRA
+                                                                               : MotorTodosPares::FLOYD_WARSHALL;
+        if (benchmark && !floydSemEstouro(g)) {
+            cerr << "Dijkstra repetido: " << chrono::duration<double, milli>(t1 - t0).count() << " ms" << endl;
+            cerr << "Floyd–Warshall em blocos não comparado: os pesos podem estourar a matriz" << endl;
+        } else if (benchmark) {
+            auto t2 = chrono::steady_clock::now();
+            vector<vector<int>> distanciasOutro = todosOsPares(g, outro, numThreads);
+            auto t3 = chrono::steady_clock::now();
+
+            auto nome = [](MotorTodosPares m) {
+                return m == MotorTodosPares::FLOYD_WARSHALL ? "Floyd–Warshall em blocos" : "Dijkstra repetido";
+            };
+            cerr << nome(escolhido) << " (escolhido): " << chrono::duration<double, milli>(t1 - t0).count() << " ms" << endl;
+            cerr << nome(outro) << ": " << chrono::duration<double, milli>(t3 - t2).count() << " ms" << endl;
+            if (distancias != distanciasOutro) {
+                cerr << "Erro: matrizes divergentes entre os motores" << endl;
+                return 1;
+            }
+        }
+
+        ostream* output = &cout;
+        ofstream outFile;
+        if (!arquivoSaida.empty()) {
+            outFile.open(arquivoSaida, saidaBinaria ? ios::binary : ios::out);
+            if (!outFile.is_open()) {
+                cerr << "Erro ao abrir arquivo de saída: " << arquivoSaida << endl;
+                return 1;
+            }
+            output = &outFile;
+        }
+
+        if (saidaBinaria) {
+            imprimirMatrizBinaria(distancias, *output);
+        } else {
+            for (int s = 0; s < (int)distancias.size(); s++) {
+                imprimirResultados(distancias[s], s, *output);
+            }
+        }
+        return 0;
+    }
+
+    if (pontoAPonto) {
+        int n = g.obterNumVertices();
+        if (inicio < 0 || inicio >= n || destino < 0 || destino >= n) {
+            cerr << "Erro: vértices de origem e destino devem estar entre 1 e " << n << "." << endl;
+            return 1;
+        }
+
+        if (usarCompacta) g.compactar();
+
+        Landmarks landmarks;
+        if (!arquivoLandmarks.empty()) {
+            landmarks = carregarLandmarks(arquivoLandmarks, g);
+        }
+        const Landmarks* usados = arquivoLandmarks.empty() ? nullptr : &landmarks;
+
+        int fixadosDijkstra = 0, fixadosALT = 0;
+        auto t0 = chrono::steady_clock::now();
+        int distancia = g.distanciaPontoAPonto(inicio, destino, usados, &fixadosALT);
+        auto t1 = chrono::steady_clock::now();
+
+        if (benchmark) {
+            auto t2 = chrono::steady_clock::now();
+            int distanciaDijkstra = g.distanciaPontoAPonto(inicio, destino, nullptr, &fixadosDijkstra);
+            auto t3 = chrono::steady_clock::now();
+
+            cerr << "Dijkstra: " << fixadosDijkstra << " vértices fixados, "
+                 << chrono::duration<double, milli>(t3 - t2).count() << " ms" << endl;
+            if (usados) {
+                cerr << "ALT (" << landmarks.vertices.size() << " landmarks): " << fixadosALT << " vértices fixados, "
+                     << chrono::duration<double, milli>(t1 - t0).count() << " ms" << endl;
+            }
+            if (distancia != distanciaDijkstra) {
+                cerr << "Erro: distâncias divergentes (" << distancia << " != " << distanciaDijkstra << ")" << endl;
+                return 1;
+            }
+        }
+
+        ostream* output = &cout;
+        ofstream outFile;
+        if (!arquivoSaida.empty()) {
+            outFile.open(arquivoSaida);
+            if (!outFile.is_open()) {
+                cerr << "Erro ao abrir arquivo de saída: " << arquivoSaida << endl;
+                return 1;
+            }
+            output = &outFile;
+        }
+        *output << (destino + 1) << ":" << (distancia == INT_MAX ? -1 : distancia) << endl;
+        return 0;
+    }
+
+    if (inicio < 0 || inicio >= g.obterNumVertices()) {
+        cerr << "Erro: vértice inicial deve estar entre 1 e " << g.obterNumVertices() << "." << endl;
+        return 1;
+    }
+
+    vector<int> distancias;
+
+    if (benchmark) {
+        // Dijkstra numa cópia compactada, para alternar as medições com a lista comum
+        Grafo compacto = g;
+        compacto.compactar();
+        size_t memoriaLista = g.memoriaAdjacencia();
+        size_t memoriaCompacta = compacto.memoriaAdjacencia();
+
+        vector<int> distanciasCompacta;
+        pair<double, double> tempos = medirAlternado([&]() { distancias = g.dijkstra(inicio); },
+                                                     [&]() { distanciasCompacta = compacto.dijkstra(inicio); });
+
+        cerr << "Lista comum:    " << memoriaLista << " bytes, " << tempos.first << " ms (mediana)" << endl;
+        cerr << "Lista compacta: " << memoriaCompacta << " bytes, " << tempos.second << " ms (mediana)" << endl;
+        cerr << "Redução de memória: " << (double)memoriaLista / max<size_t>(memoriaCompacta, 1) << "x" << endl;
+        if (distancias != distanciasCompacta) {
+            cerr << "Erro: distâncias divergentes entre as listas comum e compacta" << endl;
+            return 1;
+        }
+
+        if (g.temPesoUniforme()) {
+            vector<int> niveis;
+            pair<double, double> temposBusca = medirAlternado([&]() { distancias = g.dijkstra(inicio); },
+                                                              [&]() { niveis = g.buscaEmLargura(inicio, numThreads); });
+
+            cerr << "Busca em largura (" << numThreads << " threads): " << temposBusca.second << " ms (mediana), "
+                 << temposBusca.first / max(temposBusca.second, 1e-6) << "x mais rápida que o heap" << endl;
+            if (niveis != distancias) {
+                cerr << "Erro: distâncias divergentes entre a busca em largura e o heap" << endl;
+                return 1;
+            }
+        }
+    } else {
+        if (usarCompacta) g.compactar();
+        distancias = g.preferirBuscaEmLargura() ? g.buscaEmLargura(inicio, numThreads) : g.dijkstra(inicio);
+    }
 
     // Output
     if (!arquivoSaida.empty()) {
@@ -6,6 +6,11 @@
 #include <string>
 #include <algorithm>
 #include <functional>
+#include <cstdint>
+#include <thread>
+#include "../comum/lista_adj_compacta.h"
+#include "../comum/medicao.h"
+#include "../comum/lote.h"
 using namespace std;
 
 class Grafo {
@@ -13,46 +18,150 @@ private:
     int numVertices;
     vector<vector<int>> listaAdj;
     vector<vector<int>> listaAdjTransposta;
+    ListaAdjCompacta compacta;
+    ListaAdjCompacta compactaTransposta;
+    bool compactado;
+
+    // Vértice em visita nas DFS iterativas e onde parou a leitura dos vizinhos
+    // dele (na lista comum, posicao e fim são índices de listaAdj[v])
+    struct Quadro {
+        int v;
+        ListaAdjCompacta::Cursor cursor;
+    };
+
+    // Estado das DFS, mantido entre execuções para reaproveitar a memória
+    vector<bool> visitado;
+    stack<int, vector<int>> pilha;
+    vector<Quadro> quadros;
+
+    Quadro abrirQuadro(int v, bool transposto) const {
+        if (compactado) {
+            return Quadro{v, (transposto ? compactaTransposta : compacta).cursor(v)};
+        }
+        return Quadro{v, {0, (transposto ? listaAdjTransposta : listaAdj)[v].size(), 0}};
+    }
+
+    bool proximoVizinho(Quadro& quadro, bool transposto, int& vizinho) const {
+        if (compactado) {
+            int peso;
+            return (transposto ? compactaTransposta : compacta).proximoVizinho(quadro.cursor, vizinho, peso);
+        }
+        if (quadro.cursor.posicao == quadro.cursor.fim) return false;
+        vizinho = (transposto ? listaAdjTransposta : listaAdj)[quadro.v][quadro.cursor.posicao++];
+        return true;
+    }
 
 public:
-    Grafo(int vertices) : numVertices(vertices) {
+    Grafo(int vertices) : numVertices(vertices), compactado(false) {
         listaAdj.resize(vertices);
         listaAdjTransposta.resize(vertices);
     }
 
+    // Esvazia as listas direta e transposta sem devolver a capacidade delas e
+    // descarta a forma compacta, se houver; o próximo arquivo do lote é lido aqui
+    void reiniciar(int vertices) {
+        numVertices = vertices;
+        if (compactado) {
+            compacta.limpar();
+            compactaTransposta.limpar();
+            compactado = false;
+        }
+        if ((int)listaAdj.size() < vertices) {
+            listaAdj.resize(vertices);
+            listaAdjTransposta.resize(vertices);
+        }
+        for (int v = 0; v < vertices; v++) {
+            listaAdj[v].clear();
+            listaAdjTransposta[v].clear();
+        }
+    }
+
     void adicionarAresta(int u, int v) {
         listaAdj[u].push_back(v);
         listaAdjTransposta[v].push_back(u);
     }
 
-    void DFS(int v, vector<bool>& visitado, stack<int>& pilha, const vector<vector<int>>& grafo) {
+    // Converte as listas de adjacência para a forma compacta e libera as originais
+    void compactar() {
+        if (compactado) return;
+
+        for (int v = 0; v < numVertices; v++) {
+            sort(listaAdj[v].begin(), listaAdj[v].end());
+            sort(listaAdjTransposta[v].begin(), listaAdjTransposta[v].end());
+            for (int vizinho : listaAdj[v]) {
+                compacta.adicionarVizinho(vizinho, 0);
+            }
+            for (int vizinho : listaAdjTransposta[v]) {
+                compactaTransposta.adicionarVizinho(vizinho, 0);
+            }
+            compacta.fecharVertice();
+            compactaTransposta.fecharVertice();
+        }
+        compacta.finalizar();
+        compactaTransposta.finalizar();
+
+        vector<vector<int>>().swap(listaAdj);
+        vector<vector<int>>().swap(listaAdjTransposta);
+        compactado = true;
+    }
+
+    size_t memoriaAdjacencia() const {
+        if (compactado) return compacta.memoriaBytes() + compactaTransposta.memoriaBytes();
+
+        size_t total = (listaAdj.capacity() + listaAdjTransposta.capacity()) * sizeof(vector<int>);
+        for (int v = 0; v < numVertices; v++) {
+            total += (listaAdj[v].capacity() + listaAdjTransposta[v].capacity()) * sizeof(int);
+        }
+        return total;
+    }
+
+    // As DFS são iterativas, com os quadros numa pilha própria: caminhos longos
+    // (centenas de milhares de vértices) estouravam a pilha de chamadas
+    void DFS(int v, vector<bool>& visitado, stack<int, vector<int>>& pilha, bool transposto) {
         visitado[v] = true;
-        for (int vizinho : grafo[v]) {
-            if (!visitado[vizinho]) {
-                DFS(vizinho, visitado, pilha, grafo);
+        quadros.push_back(abrirQuadro(v, transposto));
+        while (!quadros.empty()) {
+            int vizinho;
+            if (proximoVizinho(quadros.back(), transposto, vizinho)) {
+                if (!visitado[vizinho]) {
+                    visitado[vizinho] = true;
+                    quadros.push_back(abrirQuadro(vizinho, transposto));
+                }
+            } else {
+                pilha.push(quadros.back().v);
+                quadros.pop_back();
             }
         }
-        pilha.push(v);
     }
 
-    void DFSColetar(int v, vector<bool>& visitado, vector<int>& componente, const vector<vector<int>>& grafo) {
+    void DFSColetar(int v, vector<bool>& visitado, vector<int>& componente, bool transposto) {
         visitado[v] = true;
         componente.push_back(v);
-        for (int vizinho : grafo[v]) {
-            if (!visitado[vizinho]) {
-                DFSColetar(vizinho, visitado, componente, grafo);
+        quadros.push_back(abrirQuadro(v, transposto));
+        while (!quadros.empty()) {
+            int vizinho;
+            if (proximoVizinho(quadros.back(), transposto, vizinho)) {
+                if (!visitado[vizinho]) {
+                    visitado[vizinho] = true;
+                    componente.push_back(vizinho);
+                    quadros.push_back(abrirQuadro(vizinho, transposto));
+                }
+            } else {
+                quadros.pop_back();
             }
         }
     }
 
-    vector<vector<int>> kosaraju() {
-        vector<bool> visitado(numVertices, false);
-        stack<int> pilha;
+    // Preenche componentesFortementeConexas reaproveitando os vetores já alocados nela
+    // e retorna quantos componentes achou. Só as primeiras posições valem; as demais
+    // ficam com a capacidade das execuções anteriores para a próxima chamada
+    size_t kosaraju(vector<vector<int>>& componentesFortementeConexas) {
+        visitado.assign(numVertices, false);
 
         // Primeira DFS (grafo original)
         for (int i = 0; i < numVertices; i++) {
             if (!visitado[i]) {
-                DFS(i, visitado, pilha, listaAdj);
+                DFS(i, visitado, pilha, false);
             }
         }
 
@@ -60,97 +169,160 @@ public:
         fill(visitado.begin(), visitado.end(), false);
 
         // Segunda DFS (grafo transposto)
-        vector<vector<int>> componentesFortementeConexas;
+        size_t numComponentes = 0;
         while (!pilha.empty()) {
             int v = pilha.top();
             pilha.pop();
 
             if (!visitado[v]) {
-                vector<int> componente;
-                DFSColetar(v, visitado, componente, listaAdjTransposta);
-                componentesFortementeConexas.push_back(componente);
+                if (numComponentes == componentesFortementeConexas.size()) {
+                    componentesFortementeConexas.emplace_back();
+                }
+                vector<int>& componente = componentesFortementeConexas[numComponentes++];
+                componente.clear();
+                DFSColetar(v, visitado, componente, true);
             }
         }
+        return numComponentes;
+    }
 
+    vector<vector<int>> kosaraju() {
+        vector<vector<int>> componentesFortementeConexas;
+        kosaraju(componentesFortementeConexas);
         return componentesFortementeConexas;
     }
 
     int obterNumVertices() const { return numVertices; }
 };
 
-Grafo lerFormatoSCC(const string& nomeArquivo) {
+// Carrega o arquivo em g (reiniciado); retorna false se não conseguir abri-lo
+// ou se o cabeçalho tiver um número de vértices negativo
+bool carregarFormatoSCC(const string& nomeArquivo, Grafo& g) {
     ifstream arquivo(nomeArquivo);
     if (!arquivo.is_open()) {
-        cerr << "Erro ao abrir arquivo: " << nomeArquivo << endl;
-        exit(1);
+        return false;
     }
 
     string linha;
-    int vertices, arestas;
+    int vertices = 0, arestas = 0;
 
     // Ler primeira linha: vértices arestas
     getline(arquivo, linha);
-    stringstream ss(linha);
+    istringstream ss(linha);
     ss >> vertices >> arestas;
 
-    Grafo g(vertices);
+    if (vertices < 0) {
+        return false;
+    }
+    g.reiniciar(vertices);
 
     // Ler arestas
     int arestasLidas = 0;
     while (arestasLidas < arestas && getline(arquivo, linha)) {
         if (linha.empty()) continue;
 
-        stringstream ss(linha);
+        ss.clear();
+        ss.str(linha);
         int u, v;
 
         if (ss >> u >> v) {
-            g.adicionarAresta(u - 1, v - 1); // Converter 1-based para 0-based
-            arestasLidas++;
+            if (u >= 1 && u <= vertices && v >= 1 && v <= vertices) {
+                g.adicionarAresta(u - 1, v - 1); // Converter 1-based para 0-based
+                arestasLidas++;
+            }
         }
     }
 
     arquivo.close();
-    return g;
+    return true;
 }
 
-void imprimirResultadosSCC(const vector<vector<int>>& componentesFortementeConexas, ostream& saida = cout) {
-    // Converter componentes para formato de saída
-    vector<vector<int>> componentesOrdenados;
+Grafo lerFormatoSCC(const string& nomeArquivo) {
+    Grafo g(0);
+    if (!carregarFormatoSCC(nomeArquivo, g)) {
+        cerr << "Erro ao abrir ou ler arquivo: " << nomeArquivo << endl;
+        exit(1);
+    }
+    return g;
+}
 
-    for (auto& componente : componentesFortementeConexas) {
-        vector<int> componenteOrdenado = componente;
-        sort(componenteOrdenado.begin(), componenteOrdenado.end());
-        componentesOrdenados.push_back(componenteOrdenado);
+// Forma canônica dos componentes, ordenados no próprio vetor e sem cópias:
+// vértices crescentes em cada componente e componentes pelo menor vértice.
+// Considera só os numComponentes primeiros
+void ordenarComponentes(vector<vector<int>>& componentesFortementeConexas, size_t numComponentes) {
+    auto fim = componentesFortementeConexas.begin() + numComponentes;
+    for (auto it = componentesFortementeConexas.begin(); it != fim; ++it) {
+        sort(it->begin(), it->end());
     }
 
     // Ordenar componentes pelo menor vértice
-    sort(componentesOrdenados.begin(), componentesOrdenados.end(),
+    sort(componentesFortementeConexas.begin(), fim,
          [](const vector<int>& a, const vector<int>& b) {
              return a[0] < b[0];
          });
+}
+
+void imprimirResultadosSCC(vector<vector<int>>& componentesFortementeConexas, size_t numComponentes,
+                           ostream& saida = cout) {
+    ordenarComponentes(componentesFortementeConexas, numComponentes);
 
     // Imprimir no formato esperado: uma linha por componente, vértices separados por espaço
-    for (size_t i = 0; i < componentesOrdenados.size(); i++) {
-        for (size_t j = 0; j < componentesOrdenados[i].size(); j++) {
+    for (size_t i = 0; i < numComponentes; i++) {
+        for (size_t j = 0; j < componentesFortementeConexas[i].size(); j++) {
             if (j > 0) saida << " ";
-            saida << (componentesOrdenados[i][j] + 1); // Converter para 1-based
+            saida << (componentesFortementeConexas[i][j] + 1); // Converter para 1-based
         }
-        if (i < componentesOrdenados.size() - 1) {
+        if (i < numComponentes - 1) {
             saida << endl; // Nova linha para cada componente
         }
     }
 }
 
+// Modo lote do Kosaraju: a arena da thread guarda o Grafo e os vetores de
+// componentes, reaproveitados de um arquivo para o outro.
+int executarLote(const vector<TarefaLote>& tarefas, int numThreads) {
+    struct Arena {
+        Grafo g{0};
+        vector<vector<int>> componentes;
+    };
+
+    return processarLote<Arena>(tarefas, numThreads, [](const TarefaLote& tarefa, Arena& arena, string& erro) {
+        if (!carregarFormatoSCC(tarefa.entrada, arena.g)) {
+            erro = "Erro ao abrir ou ler arquivo: " + tarefa.entrada;
+            return false;
+        }
+        size_t numComponentes = arena.g.kosaraju(arena.componentes);
+
+        ofstream saida(tarefa.saida);
+        if (!saida.is_open()) {
+            erro = "Erro ao abrir arquivo de saída: " + tarefa.saida;
+            return false;
+        }
+        imprimirResultadosSCC(arena.componentes, numComponentes, saida);
+        return true;
+    });
+}
+
 void mostrarAjuda(const string& nomePrograma) {
     cout << "Uso: " << nomePrograma << " -f <arquivo> [-o <arquivo_saida>]" << endl;
+    cout << "     " << nomePrograma << " -m <manifesto|diretório> [-o <diretório_saida>] [-t <threads>]" << endl;
     cout << "Opções:" << endl;
     cout << "  -h              : Mostra este help" << endl;
     cout << "  -f <arquivo>    : Arquivo de entrada com o grafo" << endl;
     cout << "  -o <arquivo>    : Redireciona a saída para o arquivo" << endl;
+    cout << "  -c              : Usa a lista de adjacência compacta (menos memória)" << endl;
+    cout << "  -b              : Compara memória e tempo das listas comum e compacta (em stderr)" << endl;
+    cout << "  -m <caminho>    : Modo lote: manifesto com linhas \"<entrada> <saida>\" ou diretório" << endl;
+    cout << "                    de entradas (saídas em -o <diretório>); mostra grafos/s em stderr" << endl;
+    cout << "  -t <num>        : Threads do modo lote (padrão: núcleos)" << endl;
 }
 
 int main(int argc, char* argv[]) {
     string nomeArquivo, arquivoSaida;
+    string caminhoLote;
+    int numThreads = max(1u, thread::hardware_concurrency());
+    bool usarCompacta = false;
+    bool benchmark = false;
 
     // Processar argumentos
     for (int i = 1; i < argc; i++) {
@@ -162,9 +334,23 @@ int main(int argc, char* argv[]) {
             nomeArquivo = argv[++i];
         } else if (arg == "-o" && i + 1 < argc) {
             arquivoSaida = argv[++i];
+        } else if (arg == "-m" && i + 1 < argc) {
+            caminhoLote = argv[++i];
+        } else if (arg == "-t" && i + 1 < argc) {
+            numThreads = max(1, stoi(argv[++i]));
+        } else if (arg == "-c") {
+            usarCompacta = true;
+        } else if (arg == "-b") {
+            benchmark = true;
         }
     }
 
+    if (!caminhoLote.empty()) {
+        vector<TarefaLote> tarefas;
+        if (!listarTarefasLote(caminhoLote, arquivoSaida, tarefas)) return 1;
+        return executarLote(tarefas, numThreads);
+    }
+
     if (nomeArquivo.empty()) {
         cerr << "Erro: Arquivo de entrada não especificado." << endl;
         mostrarAjuda(argv[0]);
@@ -172,20 +358,51 @@ int main(int argc, char* argv[]) {
     }
 
     Grafo g = lerFormatoSCC(nomeArquivo);
-    vector<vector<int>> componentesFortementeConexas = g.kosaraju();
+    vector<vector<int>> componentesFortementeConexas;
+    size_t numComponentes = 0;
+
+    if (benchmark) {
+        // As duas DFS rodam numa cópia compactada, intercaladas com as da lista comum
+        Grafo compacto = g;
+        compacto.compactar();
+        size_t memoriaLista = g.memoriaAdjacencia();
+        size_t memoriaCompacta = compacto.memoriaAdjacencia();
+
+        vector<vector<int>> componentesCompacta;
+        size_t numCompacta = 0;
+        pair<double, double> tempos = medirAlternado([&]() { numComponentes = g.kosaraju(componentesFortementeConexas); },
+                                                     [&]() { numCompacta = compacto.kosaraju(componentesCompacta); });
+
+        cerr << "Lista comum:    " << memoriaLista << " bytes, " << tempos.first << " ms (mediana)" << endl;
+        cerr << "Lista compacta: " << memoriaCompacta << " bytes, " << tempos.second << " ms (mediana)" << endl;
+        cerr << "Redução de memória: " << (double)memoriaLista / max<size_t>(memoriaCompacta, 1) << "x" << endl;
+
+        // A ordem das DFS muda com a lista compacta (vizinhos ordenados), os componentes não
+        ordenarComponentes(componentesFortementeConexas, numComponentes);
+        ordenarComponentes(componentesCompacta, numCompacta);
+        if (numComponentes != numCompacta ||
+            !equal(componentesFortementeConexas.begin(), componentesFortementeConexas.begin() + numComponentes,
+                   componentesCompacta.begin())) {
+            cerr << "Erro: componentes divergentes entre as listas comum e compacta" << endl;
+            return 1;
+        }
+    } else {
+        if (usarCompacta) g.compactar();
+        numComponentes = g.kosaraju(componentesFortementeConexas);
+    }
 
     // Saída
     if (!arquivoSaida.empty()) {
         ofstream arquivoSaidaStream(arquivoSaida);
         if (arquivoSaidaStream.is_open()) {
-            imprimirResultadosSCC(componentesFortementeConexas, arquivoSaidaStream);
+            imprimirResultadosSCC(componentesFortementeConexas, numComponentes, arquivoSaidaStream);
             arquivoSaidaStream.close();
         } else {
             cerr << "Erro ao abrir arquivo de saída: " << arquivoSaida << endl;
             return 1;
         }
     } else {
-        imprimirResultadosSCC(componentesFortementeConexas);
+        imprimirResultadosSCC(componentesFortementeConexas, numComponentes);
     }
 
     return 0;
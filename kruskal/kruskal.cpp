@@ -5,6 +5,8 @@
 #include <sstream>
 #include <string>
 #include <numeric>
+#include <thread>
+#include "../comum/lote.h"
 using namespace std;
 
 struct Aresta {
@@ -22,8 +24,13 @@ private:
 
 public:
     UniaoBusca(int n) {
+        reiniciar(n);
+    }
+
+    // Volta a n conjuntos unitários sem liberar a memória dos vetores
+    void reiniciar(int n) {
         pai.resize(n);
-        rank.resize(n, 0);
+        rank.assign(n, 0);
         iota(pai.begin(), pai.end(), 0);
     }
 
@@ -55,20 +62,29 @@ class Grafo {
 private:
     int numVertices;
     vector<Aresta> arestas;
+    UniaoBusca ub;
 
 public:
-    Grafo(int vertices) : numVertices(vertices) {}
+    Grafo(int vertices) : numVertices(vertices), ub(0) {}
+
+    // Descarta as arestas do arquivo anterior do lote (o vetor mantém a
+    // capacidade); a união-busca é refeita por kruskalAGM
+    void reiniciar(int vertices) {
+        numVertices = vertices;
+        arestas.clear();
+    }
 
     void adicionarAresta(int u, int v, int peso) {
         arestas.emplace_back(u, v, peso);
     }
 
-    pair<int, vector<Aresta>> kruskalAGM() {
+    // Preenche agmArestas reaproveitando a memória dela; retorna o custo da AGM
+    int kruskalAGM(vector<Aresta>& agmArestas) {
         sort(arestas.begin(), arestas.end());
 
-        UniaoBusca ub(numVertices);
+        ub.reiniciar(numVertices);
         int custoAGM = 0;
-        vector<Aresta> agmArestas;
+        agmArestas.clear();
 
         for (const Aresta& aresta : arestas) {
             if (ub.encontrar(aresta.u) != ub.encontrar(aresta.v)) {
@@ -82,43 +98,57 @@ public:
             }
         }
 
+        return custoAGM;
+    }
+
+    pair<int, vector<Aresta>> kruskalAGM() {
+        vector<Aresta> agmArestas;
+        int custoAGM = kruskalAGM(agmArestas);
         return {custoAGM, agmArestas};
     }
 };
 
-Grafo lerGrafo(const string& nomeArquivo) {
+// Carrega o arquivo em g (reiniciado); retorna false se não conseguir abri-lo
+// ou se o cabeçalho não tiver um número de vértices válido
+bool carregarGrafo(const string& nomeArquivo, Grafo& g) {
     ifstream arquivo(nomeArquivo);
     if (!arquivo.is_open()) {
-        cerr << "Erro ao abrir arquivo: " << nomeArquivo << endl;
-        exit(1);
+        return false;
     }
 
     string linha;
-    int numVertices, numArestas;
+    int numVertices = 0, numArestas = 0;
+    istringstream ss;
 
     while (getline(arquivo, linha)) {
         if (linha.empty() || linha[0] == '%') continue;
 
-        stringstream ss(linha);
+        ss.clear();
+        ss.str(linha);
         if (ss >> numVertices >> numArestas) {
             if (numVertices > 0 && numArestas > 0) break;
         }
 
-        stringstream ss2(linha);
+        ss.clear();
+        ss.str(linha);
         int linhas, colunas;
-        if (ss2 >> linhas >> colunas >> numArestas) {
+        if (ss >> linhas >> colunas >> numArestas) {
             numVertices = linhas;
             break;
         }
     }
 
-    Grafo g(numVertices);
+    if (numVertices <= 0) {
+        return false;
+    }
+    g.reiniciar(numVertices);
 
     int arestasLidas = 0;
     while (arestasLidas < numArestas && getline(arquivo, linha)) {
         if (linha.empty() || linha[0] == '%') continue;
 
-        stringstream ss(linha);
+        ss.clear();
+        ss.str(linha);
         int u, v, peso = 1;
 
         if (ss >> u >> v) {
@@ -131,21 +161,73 @@ Grafo lerGrafo(const string& nomeArquivo) {
     }
 
     arquivo.close();
+    return true;
+}
+
+Grafo lerGrafo(const string& nomeArquivo) {
+    Grafo g(0);
+    if (!carregarGrafo(nomeArquivo, g)) {
+        cerr << "Erro ao abrir ou ler arquivo: " << nomeArquivo << endl;
+        exit(1);
+    }
     return g;
 }
 
+void imprimirResultado(int custoAGM, const vector<Aresta>& arestasAGM, bool imprimirSubgrafo, ostream& output) {
+    if (!imprimirSubgrafo) {
+        output << custoAGM << endl;
+    } else {
+        for (size_t i = 0; i < arestasAGM.size(); i++) {
+            if (i > 0) output << " ";
+            output << "(" << (arestasAGM[i].u + 1) << "," << (arestasAGM[i].v + 1) << ")";
+        }
+        output << endl;
+    }
+}
+
+// Modo lote do Kruskal: a arena da thread guarda o Grafo (arestas e
+// união-busca) e o vetor de arestas da AGM.
+int executarLote(const vector<TarefaLote>& tarefas, int numThreads, bool imprimirSubgrafo) {
+    struct Arena {
+        Grafo g{0};
+        vector<Aresta> arestasAGM;
+    };
+
+    return processarLote<Arena>(tarefas, numThreads, [&](const TarefaLote& tarefa, Arena& arena, string& erro) {
+        if (!carregarGrafo(tarefa.entrada, arena.g)) {
+            erro = "Erro ao abrir ou ler arquivo: " + tarefa.entrada;
+            return false;
+        }
+        int custoAGM = arena.g.kruskalAGM(arena.arestasAGM);
+
+        ofstream saida(tarefa.saida);
+        if (!saida.is_open()) {
+            erro = "Erro ao abrir arquivo de saída: " + tarefa.saida;
+            return false;
+        }
+        imprimirResultado(custoAGM, arena.arestasAGM, imprimirSubgrafo, saida);
+        return true;
+    });
+}
+
 void mostrarHelp(const string& nomePrograma) {
     cout << "Uso: " << nomePrograma << " -f <arquivo> [-o <arquivo_saida>] [-s]" << endl;
+    cout << "     " << nomePrograma << " -m <manifesto|diretório> [-o <diretório_saida>] [-t <threads>] [-s]" << endl;
     cout << "Opções:" << endl;
     cout << "  -h              : Mostra este help" << endl;
     cout << "  -f <arquivo>    : Arquivo de entrada com o grafo" << endl;
     cout << "  -o <arquivo>    : Redireciona a saída para o arquivo" << endl;
     cout << "  -s              : Mostra a solução (arestas da AGM)" << endl;
+    cout << "  -m <caminho>    : Modo lote: manifesto com linhas \"<entrada> <saida>\" ou diretório" << endl;
+    cout << "                    de entradas (saídas em -o <diretório>); mostra grafos/s em stderr" << endl;
+    cout << "  -t <num>        : Threads do modo lote (padrão: núcleos)" << endl;
 }
 
 int main(int argc, char* argv[]) {
     string nomeArquivo, arquivoSaida;
     bool imprimirSubgrafo = false;
+    string caminhoLote;
+    int numThreads = max(1u, thread::hardware_concurrency());
 
     // Parse arguments
     for (int i = 1; i < argc; i++) {
@@ -159,9 +241,19 @@ int main(int argc, char* argv[]) {
             arquivoSaida = argv[++i];
         } else if (arg == "-s") {
             imprimirSubgrafo = true;
+        } else if (arg == "-m" && i + 1 < argc) {
+            caminhoLote = argv[++i];
+        } else if (arg == "-t" && i + 1 < argc) {
+            numThreads = max(1, stoi(argv[++i]));
         }
     }
 
+    if (!caminhoLote.empty()) {
+        vector<TarefaLote> tarefas;
+        if (!listarTarefasLote(caminhoLote, arquivoSaida, tarefas)) return 1;
+        return executarLote(tarefas, numThreads, imprimirSubgrafo);
+    }
+
     if (nomeArquivo.empty()) {
         cerr << "Erro: Arquivo de entrada não especificado." << endl;
         mostrarHelp(argv[0]);
@@ -187,15 +279,7 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    if (!imprimirSubgrafo) {
-        *output << custoAGM << endl;
-    } else {
-        for (size_t i = 0; i < arestasAGM.size(); i++) {
-            if (i > 0) *output << " ";
-            *output << "(" << (arestasAGM[i].u + 1) << "," << (arestasAGM[i].v + 1) << ")";
-        }
-        *output << endl;
-    }
+    imprimirResultado(custoAGM, arestasAGM, imprimirSubgrafo, *output);
 
     if (outFile.is_open()) {
         outFile.close();
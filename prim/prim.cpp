@@ -1,12 +1,16 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <queue>
 #include <string>
 #include <sstream>
 #include <limits>
 #include <functional>
 #include <algorithm>
+#include <cstdint>
+#include <thread>
+#include "../comum/lista_adj_compacta.h"
+#include "../comum/medicao.h"
+#include "../comum/lote.h"
 
 using namespace std;
 
@@ -15,14 +19,35 @@ const int INF = numeric_limits<int>::max();
 struct Aresta {
     int v, peso;
     Aresta(int v, int peso) : v(v), peso(peso) {}
+
+    bool operator<(const Aresta& outra) const {
+        return v < outra.v || (v == outra.v && peso < outra.peso);
+    }
 };
 
 class Grafo {
 public:
     int n, m;
     vector<vector<Aresta>> adj;
-
-    Grafo(int n) : n(n), m(0), adj(n) {}
+    ListaAdjCompacta adjCompacta;
+    bool compactado;
+
+    Grafo(int n) : n(n), m(0), adj(n), compactado(false) {}
+
+    // Volta a um grafo vazio com n vértices; as listas de adj limpas guardam a
+    // capacidade do arquivo anterior do lote
+    void reiniciar(int vertices) {
+        n = vertices;
+        m = 0;
+        if (compactado) {
+            adjCompacta.limpar();
+            compactado = false;
+        }
+        if ((int)adj.size() < n) adj.resize(n);
+        for (int v = 0; v < n; v++) {
+            adj[v].clear();
+        }
+    }
 
     void adicionaAresta(int u, int v, int peso) {
         if (u < 0 || v < 0 || u >= n || v >= n) return;
@@ -30,43 +55,105 @@ public:
         adj[v].emplace_back(u, peso);
         m++;
     }
+
+    // Converte a lista de adjacência para a forma compacta e libera a original
+    void compactar() {
+        if (compactado) return;
+
+        int menor = INF, maior = numeric_limits<int>::min();
+        for (int u = 0; u < n; u++) {
+            for (auto &aresta : adj[u]) {
+                menor = min(menor, aresta.peso);
+                maior = max(maior, aresta.peso);
+            }
+        }
+        if (menor > maior) menor = maior = 0;
+
+        adjCompacta.definirFaixaPesos(menor, maior);
+        for (int u = 0; u < n; u++) {
+            sort(adj[u].begin(), adj[u].end());
+            for (auto &aresta : adj[u]) {
+                adjCompacta.adicionarVizinho(aresta.v, aresta.peso);
+            }
+            adjCompacta.fecharVertice();
+        }
+        adjCompacta.finalizar();
+
+        vector<vector<Aresta>>().swap(adj);
+        compactado = true;
+    }
+
+    template <typename Funcao>
+    void paraCadaVizinho(int u, Funcao f) const {
+        if (compactado) {
+            adjCompacta.paraCadaVizinho(u, f);
+        } else {
+            for (auto &aresta : adj[u]) {
+                f(aresta.v, aresta.peso);
+            }
+        }
+    }
+
+    size_t memoriaAdjacencia() const {
+        if (compactado) return adjCompacta.memoriaBytes();
+
+        size_t total = adj.capacity() * sizeof(vector<Aresta>);
+        for (auto &vizinhos : adj) {
+            total += vizinhos.capacity() * sizeof(Aresta);
+        }
+        return total;
+    }
 };
 
-pair<long long, vector<pair<int, int>>> prim(Grafo &g, int inicio) {
-    int n = g.n;
-    vector<int> dist(n, INF);
-    vector<int> pai(n, -1);
-    vector<bool> visitado(n, false);
+// Vetores de trabalho do Prim, reaproveitáveis entre execuções (modo lote)
+struct MemoriaPrim {
+    vector<int> dist;
+    vector<int> pai;
+    vector<bool> visitado;
+    vector<pair<int, int>> heap;
+};
 
-    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+// Preenche arestasAGM reaproveitando a memória dela; retorna o custo da AGM
+long long prim(const Grafo &g, int inicio, MemoriaPrim &mem, vector<pair<int, int>> &arestasAGM) {
+    int n = g.n;
+    vector<int> &dist = mem.dist;
+    vector<int> &pai = mem.pai;
+    vector<bool> &visitado = mem.visitado;
+    dist.assign(n, INF);
+    pai.assign(n, -1);
+    visitado.assign(n, false);
+
+    // Heap mínimo sobre mem.heap, no lugar de uma priority_queue, para manter a memória
+    vector<pair<int, int>> &pq = mem.heap;
+    greater<pair<int, int>> comparador;
+    pq.clear();
 
     long long custoTotal = 0;
-    vector<pair<int, int>> arestasAGM;
+    arestasAGM.clear();
 
     dist[inicio] = 0;
-    pq.push({0, inicio});
+    pq.push_back({0, inicio});
 
     while (!pq.empty()) {
 
-        int d = pq.top().first;
-        int u = pq.top().second;
-        pq.pop();
+        pop_heap(pq.begin(), pq.end(), comparador);
+        int d = pq.back().first;
+        int u = pq.back().second;
+        pq.pop_back();
 
         if (visitado[u]) continue;
 
         visitado[u] = true;
         custoTotal += d;
 
-        for (auto &aresta : g.adj[u]) {
-            int v = aresta.v;
-            int peso = aresta.peso;
-
+        g.paraCadaVizinho(u, [&](int v, int peso) {
             if (!visitado[v] && peso < dist[v]) {
                 dist[v] = peso;
                 pai[v] = u;
-                pq.push({peso, v});
+                pq.push_back({peso, v});
+                push_heap(pq.begin(), pq.end(), comparador);
             }
-        }
+        });
     }
 
     // Coletar arestas da AGM
@@ -81,42 +168,57 @@ pair<long long, vector<pair<int, int>>> prim(Grafo &g, int inicio) {
     // Ordenar arestas para consistência
     sort(arestasAGM.begin(), arestasAGM.end());
 
+    return custoTotal;
+}
+
+pair<long long, vector<pair<int, int>>> prim(const Grafo &g, int inicio) {
+    MemoriaPrim mem;
+    vector<pair<int, int>> arestasAGM;
+    long long custoTotal = prim(g, inicio, mem, arestasAGM);
     return {custoTotal, arestasAGM};
 }
 
-Grafo lerGrafo(const string& nomeArquivo) {
+// Carrega o arquivo em g (reiniciado); retorna false se não conseguir abri-lo
+// ou se o cabeçalho não tiver um número de vértices válido
+bool carregarGrafo(const string& nomeArquivo, Grafo& g) {
     ifstream arquivo(nomeArquivo);
     if (!arquivo.is_open()) {
-        cerr << "Erro ao abrir arquivo: " << nomeArquivo << endl;
-        exit(1);
+        return false;
     }
 
     string linha;
-    int numVertices, numArestas;
+    int numVertices = 0, numArestas = 0;
+    istringstream ss;
 
     while (getline(arquivo, linha)) {
         if (linha.empty() || linha[0] == '%') continue;
 
-        stringstream ss(linha);
+        ss.clear();
+        ss.str(linha);
         if (ss >> numVertices >> numArestas) {
             if (numVertices > 0 && numArestas > 0) break;
         }
 
-        stringstream ss2(linha);
+        ss.clear();
+        ss.str(linha);
         int linhas, colunas;
-        if (ss2 >> linhas >> colunas >> numArestas) {
+        if (ss >> linhas >> colunas >> numArestas) {
             numVertices = linhas;
             break;
         }
     }
 
-    Grafo g(numVertices);
+    if (numVertices <= 0) {
+        return false;
+    }
+    g.reiniciar(numVertices);
 
     int arestasLidas = 0;
     while (arestasLidas < numArestas && getline(arquivo, linha)) {
         if (linha.empty() || linha[0] == '%') continue;
 
-        stringstream ss(linha);
+        ss.clear();
+        ss.str(linha);
         int u, v, peso = 1;
 
         if (ss >> u >> v) {
@@ -129,23 +231,84 @@ Grafo lerGrafo(const string& nomeArquivo) {
     }
 
     arquivo.close();
+    return true;
+}
+
+Grafo lerGrafo(const string& nomeArquivo) {
+    Grafo g(0);
+    if (!carregarGrafo(nomeArquivo, g)) {
+        cerr << "Erro ao abrir ou ler arquivo: " << nomeArquivo << endl;
+        exit(1);
+    }
     return g;
 }
 
+void imprimirResultado(long long custoAGM, const vector<pair<int, int>>& arestasAGM, bool imprimirSubgrafo, ostream& output) {
+    if (!imprimirSubgrafo) {
+        output << custoAGM << endl;
+    } else {
+        for (size_t i = 0; i < arestasAGM.size(); i++) {
+            if (i > 0) output << " ";
+            output << "(" << (arestasAGM[i].first + 1) << "," << (arestasAGM[i].second + 1) << ")";
+        }
+        output << endl;
+    }
+}
+
+// Modo lote do Prim: a arena da thread guarda o Grafo, os vetores de trabalho
+// (dist, pai, heap) e as arestas da AGM. Um -i fora do grafo conta como falha.
+int executarLote(const vector<TarefaLote>& tarefas, int numThreads, int inicio, bool imprimirSubgrafo) {
+    struct Arena {
+        Grafo g{0};
+        MemoriaPrim mem;
+        vector<pair<int, int>> arestasAGM;
+    };
+
+    return processarLote<Arena>(tarefas, numThreads, [&](const TarefaLote& tarefa, Arena& arena, string& erro) {
+        if (!carregarGrafo(tarefa.entrada, arena.g)) {
+            erro = "Erro ao abrir ou ler arquivo: " + tarefa.entrada;
+            return false;
+        }
+        if (inicio < 0 || inicio >= arena.g.n) {
+            erro = "Erro: vértice inicial fora do grafo em " + tarefa.entrada;
+            return false;
+        }
+        long long custoAGM = prim(arena.g, inicio, arena.mem, arena.arestasAGM);
+
+        ofstream saida(tarefa.saida);
+        if (!saida.is_open()) {
+            erro = "Erro ao abrir arquivo de saída: " + tarefa.saida;
+            return false;
+        }
+        imprimirResultado(custoAGM, arena.arestasAGM, imprimirSubgrafo, saida);
+        return true;
+    });
+}
+
 void mostrarHelp(const string& nomePrograma) {
     cout << "Uso: " << nomePrograma << " -f <arquivo> [-o <arquivo_saida>] [-i <vertice_inicial>] [-s]" << endl;
+    cout << "     " << nomePrograma << " -m <manifesto|diretório> [-o <diretório_saida>] [-t <threads>] [-i <vertice_inicial>] [-s]" << endl;
     cout << "Opções:" << endl;
     cout << "  -h              : Mostra este help" << endl;
     cout << "  -f <arquivo>    : Arquivo de entrada com o grafo" << endl;
     cout << "  -o <arquivo>    : Redireciona a saída para o arquivo" << endl;
     cout << "  -i <vertice>    : Vértice inicial (padrão: 1)" << endl;
     cout << "  -s              : Mostra a solução (arestas da AGM)" << endl;
+    cout << "  -c              : Usa a lista de adjacência compacta (menos memória)" << endl;
+    cout << "  -b              : Compara memória e tempo das listas comum e compacta (em stderr)" << endl;
+    cout << "  -m <caminho>    : Modo lote: manifesto com linhas \"<entrada> <saida>\" ou diretório" << endl;
+    cout << "                    de entradas (saídas em -o <diretório>); mostra grafos/s em stderr" << endl;
+    cout << "  -t <num>        : Threads do modo lote (padrão: núcleos)" << endl;
 }
 
 int main(int argc, char *argv[]) {
     string nomeArquivo, arquivoSaida;
     bool imprimirSubgrafo = false;
     int inicio = 0; // 0-based, padrão vértice 1
+    bool usarCompacta = false;
+    bool benchmark = false;
+    string caminhoLote;
+    int numThreads = max(1u, thread::hardware_concurrency());
 
     // Parse arguments
     for (int i = 1; i < argc; i++) {
@@ -161,9 +324,23 @@ int main(int argc, char *argv[]) {
             imprimirSubgrafo = true;
         } else if (arg == "-i" && i + 1 < argc) {
             inicio = stoi(argv[++i]) - 1; // Converter para 0-based
+        } else if (arg == "-m" && i + 1 < argc) {
+            caminhoLote = argv[++i];
+        } else if (arg == "-t" && i + 1 < argc) {
+            numThreads = max(1, stoi(argv[++i]));
+        } else if (arg == "-c") {
+            usarCompacta = true;
+        } else if (arg == "-b") {
+            benchmark = true;
         }
     }
 
+    if (!caminhoLote.empty()) {
+        vector<TarefaLote> tarefas;
+        if (!listarTarefasLote(caminhoLote, arquivoSaida, tarefas)) return 1;
+        return executarLote(tarefas, numThreads, inicio, imprimirSubgrafo);
+    }
+
     if (nomeArquivo.empty()) {
         cerr << "Erro: Arquivo de entrada não especificado." << endl;
         mostrarHelp(argv[0]);
@@ -171,7 +348,34 @@ int main(int argc, char *argv[]) {
     }
 
     Grafo g = lerGrafo(nomeArquivo);
-    pair<long long, vector<pair<int, int>>> resultado = prim(g, inicio);
+    if (inicio < 0 || inicio >= g.n) {
+        cerr << "Erro: vértice inicial fora do grafo." << endl;
+        return 1;
+    }
+    pair<long long, vector<pair<int, int>>> resultado;
+
+    if (benchmark) {
+        // Uma cópia compactada permite alternar as medições entre as duas formas
+        Grafo compacto = g;
+        compacto.compactar();
+        size_t memoriaLista = g.memoriaAdjacencia();
+        size_t memoriaCompacta = compacto.memoriaAdjacencia();
+
+        pair<long long, vector<pair<int, int>>> resultadoCompacta;
+        pair<double, double> tempos = medirAlternado([&]() { resultado = prim(g, inicio); },
+                                                     [&]() { resultadoCompacta = prim(compacto, inicio); });
+
+        cerr << "Lista comum:    " << memoriaLista << " bytes, " << tempos.first << " ms (mediana)" << endl;
+        cerr << "Lista compacta: " << memoriaCompacta << " bytes, " << tempos.second << " ms (mediana)" << endl;
+        cerr << "Redução de memória: " << (double)memoriaLista / max<size_t>(memoriaCompacta, 1) << "x" << endl;
+        if (resultado != resultadoCompacta) {
+            cerr << "Erro: AGMs divergentes entre as listas comum e compacta" << endl;
+            return 1;
+        }
+    } else {
+        if (usarCompacta) g.compactar();
+        resultado = prim(g, inicio);
+    }
     long long custoAGM = resultado.first;
     vector<pair<int, int>> arestasAGM = resultado.second;
 
@@ -189,15 +393,7 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    if (!imprimirSubgrafo) {
-        *output << custoAGM << endl;
-    } else {
-        for (size_t i = 0; i < arestasAGM.size(); i++) {
-            if (i > 0) *output << " ";
-            *output << "(" << (arestasAGM[i].first + 1) << "," << (arestasAGM[i].second + 1) << ")";
-        }
-        *output << endl;
-    }
+    imprimirResultado(custoAGM, arestasAGM, imprimirSubgrafo, *output);
 
     if (outFile.is_open()) {
         outFile.close();